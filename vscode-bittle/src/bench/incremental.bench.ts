@@ -0,0 +1,44 @@
+import path from 'path';
+import { bench, describe, vi } from 'vitest';
+import { compilerSources, createServices, reportHeap } from './workspace';
+
+vi.mock('../log', () => ({ log: { log: () => { } } }));
+
+// The diagnostics of the open files are queried again after every edit, as
+// the diagnostics provider does, so this goes through the cache end to end.
+describe('edit and re-query diagnostics', () => {
+    const files = compilerSources();
+    const compilerRoot = path.dirname(Array.from(files.keys()).find(p => p.endsWith('/main.btl'))!);
+    const openFiles = ['main.btl', 'semantics/elab.btl', 'support/utils.btl'].map(p => path.join(compilerRoot, p));
+    const edited = path.join(compilerRoot, 'support/utils.btl');
+    const text = files.get(edited)!;
+
+    const services = createServices(files);
+    const queryDiagnostics = () => {
+        for (const file of openFiles) {
+            services.semanticsService.getDiagnostics(file);
+        }
+    };
+    reportHeap('compiler: diagnostics of the open files', queryDiagnostics);
+
+    // Alternates between two versions, so every run sees a change.
+    let version = 0;
+    const edit = (makeEdit: (text: string) => string) => {
+        version++;
+        services.vfs.writeFile(edited, version % 2 === 0 ? text : makeEdit(text));
+    };
+
+    bench('no edit', () => {
+        queryDiagnostics();
+    });
+
+    bench('edit a function body', () => {
+        edit(text => text.replace('return -1;', 'return -2;'));
+        queryDiagnostics();
+    });
+
+    bench('edit a signature', () => {
+        edit(text => text.replace('func str_eq(', 'func str_eq_(a: Int, '));
+        queryDiagnostics();
+    });
+});
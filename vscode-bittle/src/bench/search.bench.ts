@@ -0,0 +1,38 @@
+import { bench, describe } from 'vitest';
+import { parse } from '../syntax/reparser';
+import { fuzzySearch } from '../utils/fuzzySearch';
+import { compilerSources, syntheticWorkspace } from './workspace';
+
+// The names declared at the top level of every file, as workspace symbol
+// search and completion see them
+function topLevelNames(files: Map<string, string>): { name: string }[] {
+    const names: { name: string }[] = [];
+    for (const text of files.values()) {
+        for (const node of parse(text).tree.rootNode.children) {
+            const nameNode = node.childForFieldName('name');
+            if (nameNode) {
+                names.push({ name: nameNode.text });
+            }
+        }
+    }
+    return names;
+}
+
+const symbols = [
+    ...topLevelNames(compilerSources()),
+    ...topLevelNames(syntheticWorkspace(2000)),
+];
+
+describe(`fuzzy search: ${symbols.length} symbols`, () => {
+    bench('short query', () => {
+        fuzzySearch('el', symbols, { key: 'name' });
+    });
+
+    bench('long query', () => {
+        fuzzySearch('elab_decl', symbols, { key: 'name' });
+    });
+
+    bench('no matches', () => {
+        fuzzySearch('zzqx', symbols, { key: 'name' });
+    });
+});
@@ -0,0 +1,51 @@
+import { bench, describe, vi } from 'vitest';
+import { analyzeControlFlow } from '../semantics/controlFlowAnalyzer';
+import { Elaborator } from '../semantics/elaborator';
+import { ParsingService } from '../services/parsingService';
+import { ReactiveCache } from '../utils/reactiveCache';
+import { compilerSources, createServices, reportHeap, syntheticWorkspace } from './workspace';
+
+vi.mock('../log', () => ({ log: { log: () => { } } }));
+
+const corpora = [
+    ['compiler', compilerSources()],
+    ['synthetic', syntheticWorkspace(200)],
+] as const;
+
+for (const [name, files] of corpora) {
+    const paths = Array.from(files.keys());
+
+    // Parsed once up front, so that elaborating can be measured on its own
+    const warm = createServices(files);
+    for (const path of paths) {
+        warm.parsingService.parse(path);
+    }
+    const parsed: ParsingService = {
+        parse: path => warm.parsingService.parse(path),
+        parseAsAst: path => warm.parsingService.parseAsAst(path),
+        parseErrors: path => warm.parsingService.parseErrors(path),
+    };
+    const elaborateAll = (cache: ReactiveCache) =>
+        paths.map(path => Elaborator.elaborate(parsed, warm.pathResolver, cache, path));
+
+    const results = reportHeap(`${name}: elaboration results`, () => elaborateAll(new ReactiveCache()));
+
+    describe(`semantics: ${name}`, () => {
+        bench('parse and elaborate', () => {
+            const { semanticsService } = createServices(files);
+            for (const path of paths) {
+                semanticsService.referencesByName(path);
+            }
+        });
+
+        bench('elaborate', () => {
+            elaborateAll(new ReactiveCache());
+        });
+
+        bench('analyze control flow', () => {
+            for (let i = 0; i < paths.length; i++) {
+                analyzeControlFlow(paths[i], parsed.parseAsAst(paths[i]), results[i]);
+            }
+        });
+    });
+}
@@ -0,0 +1,77 @@
+import { bench, describe } from 'vitest';
+import { ErrorSink } from '../syntax/errorSink';
+import { Lexer } from '../syntax/lexer';
+import { parse, reparse } from '../syntax/reparser';
+import { SyntaxNode } from '../syntax/tree';
+import { compilerSources, reportHeap, syntheticWorkspace } from './workspace';
+
+const ignoreErrors: ErrorSink = { add: () => { } };
+
+const corpora = [
+    ['compiler', compilerSources()],
+    ['synthetic', syntheticWorkspace(200)],
+] as const;
+
+function countTokens(text: string): number {
+    const lexer = new Lexer(text, ignoreErrors);
+    let n = 0;
+    while (lexer.scanToken().kind !== '<eof>') {
+        n++;
+    }
+    return n;
+}
+
+function countNodes(node: SyntaxNode): number {
+    let n = 1;
+    for (const child of node.children) {
+        n += countNodes(child);
+    }
+    return n;
+}
+
+for (const [name, files] of corpora) {
+    const texts = Array.from(files.values());
+    const trees = reportHeap(`${name}: syntax trees`, () => texts.map(text => parse(text).tree));
+
+    describe(`syntax: ${name}`, () => {
+        bench('lex', () => {
+            for (const text of texts) {
+                countTokens(text);
+            }
+        });
+
+        bench('parse', () => {
+            for (const text of texts) {
+                parse(text);
+            }
+        });
+
+        bench('walk trees', () => {
+            for (const tree of trees) {
+                countNodes(tree.rootNode);
+            }
+        });
+    });
+}
+
+describe('syntax: edit', () => {
+    // The largest file, with one character typed in the middle of it
+    const text = Array.from(compilerSources().values()).reduce((a, b) => (a.length >= b.length ? a : b));
+    const offset = text.indexOf('\n', text.length / 2) + 1;
+    const edited = text.slice(0, offset) + ' ' + text.slice(offset);
+    const change = { startIndex: offset, oldEndIndex: offset, newEndIndex: offset + 1 };
+
+    bench('parse after an edit', () => {
+        parse(edited);
+    });
+
+    // Reparsing takes over the old tree, so each run needs its own.
+    let old = parse(text);
+    bench('reparse after an edit', () => {
+        reparse(old, edited, change);
+    }, {
+        setup: () => {
+            old = parse(text);
+        },
+    });
+});
@@ -0,0 +1,139 @@
+import * as fs from 'fs';
+import path from 'path';
+import type { FileChange, VirtualFileSystem } from '../services/vfs';
+import { ParsingServiceImpl } from '../services/parsingService';
+import { PathResolver } from '../services/pathResolver';
+import { SemanticsService } from '../services/semanticsService';
+import { ReactiveCache } from '../utils/reactiveCache';
+
+/** The sources of the compiler, which are the largest Bittle code base around. */
+export function compilerSources(): Map<string, string> {
+    const root = path.resolve(__dirname, '../../../compiler/src');
+    const files = new Map<string, string>();
+    for (const entry of fs.readdirSync(root, { recursive: true, encoding: 'utf8' })) {
+        if (entry.endsWith('.btl')) {
+            const filePath = path.join(root, entry);
+            files.set(filePath, fs.readFileSync(filePath, 'utf8'));
+        }
+    }
+    return files;
+}
+
+/**
+ * A generated workspace of `n` modules, each of which imports up to two of the
+ * modules before it and calls into them, so that the import graph is deep
+ * rather than wide.
+ */
+export function syntheticWorkspace(n: number): Map<string, string> {
+    const files = new Map<string, string>();
+    for (let i = 0; i < n; i++) {
+        const imports = [i - 1, Math.floor(i / 2) - 1].filter((j, k, all) => j >= 0 && all.indexOf(j) === k);
+        files.set(`/synthetic/mod${i}.btl`, syntheticModule(i, imports));
+    }
+    return files;
+}
+
+function syntheticModule(i: number, imports: number[]): string {
+    let text = `module mod${i};\n\n`;
+    for (const j of imports) {
+        text += `import "mod${j}";\n`;
+    }
+    text += `
+struct Rec${i} {
+    count: Int,
+    next: *mut Rec${i},
+    values: [Int; 4],
+}
+
+enum Kind${i} {
+    Kind${i}_First,
+    Kind${i}_Second,
+}
+
+const LIMIT${i} = ${i + 10};
+`;
+    for (let k = 0; k < 8; k++) {
+        const callee = imports.length > 0 ? `f${imports[0]}_${k}` : `f${i}_${Math.max(k - 1, 0)}`;
+        text += `
+func f${i}_${k}(rec: *mut Rec${i}, n: Int): Int {
+    var total = 0;
+    for (var x = 0; x < n; x += 1) {
+        if (x % 2 == 0) {
+            total += rec.count + rec.values[x % 4];
+        } else {
+            total -= ${k === 0 && imports.length === 0 ? '1' : `${callee}(null, x)`};
+        }
+    }
+    match (n) {
+        case 0: {
+            return LIMIT${i};
+        }
+        case _: {
+            total += Kind${i}_Second;
+        }
+    }
+    return total;
+}
+`;
+    }
+    return text;
+}
+
+/** A file system over a fixed set of files, which can be edited. */
+export class MemoryFileSystem implements VirtualFileSystem {
+    private files: Map<string, string>;
+
+    constructor(
+        files: Map<string, string>,
+        private cache: ReactiveCache,
+    ) {
+        this.files = new Map(files);
+    }
+
+    readFile(path: string): string {
+        return this.cache.compute(`vfs:read:${path}`, () => this.files.get(path) ?? '');
+    }
+
+    exists(path: string): boolean {
+        return this.cache.compute(`vfs:exists:${path}`, () => this.files.has(path));
+    }
+
+    listFiles(): string[] {
+        return this.cache.compute(`vfs:list`, () => Array.from(this.files.keys()));
+    }
+
+    lastChange(_path: string): FileChange | undefined {
+        return undefined;
+    }
+
+    onDidChangeFile = () => ({ dispose: () => { } });
+
+    writeFile(path: string, text: string) {
+        this.files.set(path, text);
+        this.cache.invalidate(`vfs:read:${path}`);
+    }
+}
+
+export function createServices(files: Map<string, string>) {
+    const cache = new ReactiveCache();
+    const vfs = new MemoryFileSystem(files, cache);
+    const parsingService = new ParsingServiceImpl(cache, vfs);
+    const pathResolver = new PathResolver(vfs);
+    const semanticsService = new SemanticsService(parsingService, pathResolver, cache);
+    return { cache, vfs, parsingService, pathResolver, semanticsService };
+}
+
+/**
+ * Logs how much heap the result of `fn` keeps alive. More precise when run
+ * with `--expose-gc`, as with `npm run bench`.
+ */
+export function reportHeap<T>(label: string, fn: () => T): T {
+    const gc = (globalThis as { gc?: () => void }).gc;
+    gc?.();
+    const before = process.memoryUsage().heapUsed;
+    const result = fn();
+    gc?.();
+    const after = process.memoryUsage().heapUsed;
+    console.log(`${label}: ${((after - before) / 1024 / 1024).toFixed(1)} MB retained`);
+    return result;
+}
@@ -16,6 +16,8 @@ import { FileGraphService } from './services/fileGraphService';
 import { ModuleListService } from './services/moduleListService';
 import { ParsingServiceImpl } from './services/parsingService';
 import { PathResolver } from './services/pathResolver';
+import { PersistentCache } from './services/persistentCache';
+import { ReferenceIndexService } from './services/referenceIndexService';
 import { SemanticsService } from './services/semanticsService';
 import { VirtualFileSystemImpl } from './services/vfs';
 import { ReactiveCache } from './utils/reactiveCache';
@@ -25,6 +27,9 @@ export function activate(context: vscode.ExtensionContext) {
 
     const cache = new ReactiveCache();
 
+    const persistentCache = new PersistentCache(context.storageUri?.fsPath, context.extension.packageJSON.version);
+    context.subscriptions.push(persistentCache);
+
     const vfs = new VirtualFileSystemImpl(cache);
     context.subscriptions.push(vfs);
 
@@ -34,11 +39,15 @@ export function activate(context: vscode.ExtensionContext) {
 
     const semanticsService = new SemanticsService(parsingService, pathResolver, cache);
 
-    const fileGraphService = new FileGraphService(parsingService, vfs, pathResolver);
+    const fileGraphService = new FileGraphService(parsingService, vfs, pathResolver, cache, persistentCache);
+
+    const moduleListService = new ModuleListService(parsingService, vfs, cache, persistentCache);
 
-    const moduleListService = new ModuleListService(parsingService, vfs, cache);
+    const referenceIndexService = new ReferenceIndexService(semanticsService, vfs, cache);
+    context.subscriptions.push(referenceIndexService);
 
     const compilerService = new CompilerService();
+    context.subscriptions.push(compilerService);
 
     // Hover
 
@@ -73,7 +82,7 @@ export function activate(context: vscode.ExtensionContext) {
             return;
 
         syntaxErrorProvider.updateDiagnostics(document);
-        elaborationErrorProvider.updateDiagnostics();
+        elaborationErrorProvider.scheduleUpdate();
         compilerErrorProvider.updateDiagnostics();
     }
 
@@ -86,7 +95,7 @@ export function activate(context: vscode.ExtensionContext) {
 
     // Document symbols and workspace symbols
 
-    const symbolProvider = new SymbolProvider(parsingService, vfs, cache);
+    const symbolProvider = new SymbolProvider(parsingService, vfs, cache, persistentCache);
     context.subscriptions.push(
         vscode.languages.registerDocumentSymbolProvider('bittle', symbolProvider),
         vscode.languages.registerWorkspaceSymbolProvider(symbolProvider),
@@ -120,7 +129,7 @@ export function activate(context: vscode.ExtensionContext) {
 
     // Rename and references
 
-    const referenceProvider = new ReferenceProvider(parsingService, semanticsService, fileGraphService);
+    const referenceProvider = new ReferenceProvider(parsingService, semanticsService, fileGraphService, referenceIndexService);
     context.subscriptions.push(
         vscode.languages.registerReferenceProvider('bittle', referenceProvider),
         vscode.languages.registerRenameProvider('bittle', referenceProvider),
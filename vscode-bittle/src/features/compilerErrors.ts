@@ -1,6 +1,6 @@
 import * as vscode from 'vscode';
 import { log } from '../log';
-import { CompilerService } from '../services/compilerService';
+import { CheckResult, CompilerError, CompilerService } from '../services/compilerService';
 import { interceptExceptionsAsync } from '../utils/interceptExceptions';
 import { stream } from '../utils/stream';
 
@@ -44,10 +44,7 @@ class CompilerErrorProviderImpl implements CompilerErrorProvider {
         const fileDiagnostics = [];
         for (const document of vscode.workspace.textDocuments) {
             if (!document.isDirty && document.fileName.endsWith('.btl') && document.uri.scheme === 'file') {
-                const fileDiagnostic = await this.getFileDiagnostic(document);
-                if (fileDiagnostic) {
-                    fileDiagnostics.push(fileDiagnostic);
-                }
+                fileDiagnostics.push(...await this.getFileDiagnostics(document));
             }
         }
 
@@ -59,16 +56,21 @@ class CompilerErrorProviderImpl implements CompilerErrorProvider {
         }
     }
 
-    async getFileDiagnostic(document: vscode.TextDocument) {
-        const { exitCode, stderr } = await this.compilerService.compile(document.fileName);
+    async getFileDiagnostics(document: vscode.TextDocument): Promise<FileDiagnostic[]> {
+        const result = await this.compilerService.check(document.fileName);
 
-        log.log(`Compiler exited with code ${exitCode}.`);
-        log.log(`Compiler output: ${stderr}`);
+        log.log(`Compiler exited with code ${result.exitCode}.`);
+        if (result.stderr) {
+            log.log(`Compiler output: ${result.stderr}`);
+        }
 
-        if (exitCode === 0) {
-            return;
+        if (result.exitCode === 0) {
+            return [];
+        }
+        if (result.errors.length === 0) {
+            return [makeUnknownDiagnostic(result, document)];
         }
-        return makeDiagnostic(exitCode, stderr, document);
+        return result.errors.map(error => makeDiagnostic(error, document));
     }
 }
 
@@ -77,49 +79,49 @@ type FileDiagnostic = {
     diagnostic: vscode.Diagnostic;
 };
 
-function makeDiagnostic(exitCode: number | undefined, stderr: string, document: vscode.TextDocument): FileDiagnostic {
-    const match = /^(.*?):(\d+):(\d+):(.*)/s.exec(stderr);
-    if (match) {
-        let fileName = match[1];
-        if (fileName === '<stdin>') {
-            fileName = document.fileName;
-        }
-        const row = parseInt(match[2]) - 1;
-        const col = parseInt(match[3]) - 1;
-        const diagnostic = new vscode.Diagnostic(
-            new vscode.Range(row, col, row, col),
-            match[4].trim(),
-            vscode.DiagnosticSeverity.Error,
-        );
-        diagnostic.source = 'Bittle compiler';
-        if (fileName !== document.fileName) {
-            diagnostic.relatedInformation = [
-                new vscode.DiagnosticRelatedInformation(
-                    new vscode.Location(document.uri, new vscode.Range(0, 0, 0, 0)),
-                    `From compiler output for ${fileName}`,
-                ),
-            ];
-        }
-        return {
-            fileName,
-            diagnostic,
-        };
+function makeDiagnostic(error: CompilerError, document: vscode.TextDocument): FileDiagnostic {
+    let fileName = error.file ?? document.fileName;
+    if (fileName === '<stdin>') {
+        fileName = document.fileName;
+    }
+    const row = Math.max(error.line - 1, 0);
+    const col = Math.max(error.column - 1, 0);
+    const diagnostic = new vscode.Diagnostic(
+        new vscode.Range(row, col, row, col),
+        error.message,
+        vscode.DiagnosticSeverity.Error,
+    );
+    diagnostic.source = 'Bittle compiler';
+    if (fileName !== document.fileName) {
+        diagnostic.relatedInformation = [
+            new vscode.DiagnosticRelatedInformation(
+                new vscode.Location(document.uri, new vscode.Range(0, 0, 0, 0)),
+                `From compiler output for ${fileName}`,
+            ),
+        ];
+    }
+    return {
+        fileName,
+        diagnostic,
+    };
+}
+
+// For a compiler that failed without reporting an error, such as one that crashed.
+function makeUnknownDiagnostic(result: CheckResult, document: vscode.TextDocument): FileDiagnostic {
+    let message: string;
+    if (result.stderr.trim()) {
+        message = 'Compiler error: ' + result.stderr;
     } else {
-        let message: string;
-        if (stderr.trim()) {
-            message = 'Compiler error: ' + stderr;
-        } else {
-            message = `Unknown compiler error (exit code ${exitCode}).`;
-        }
-        const diagnostic = new vscode.Diagnostic(
-            new vscode.Range(0, 0, 0, 0),
-            message,
-            vscode.DiagnosticSeverity.Error,
-        );
-        diagnostic.source = 'Bittle compiler';
-        return {
-            fileName: document.fileName,
-            diagnostic,
-        };
+        message = `Unknown compiler error (exit code ${result.exitCode}).`;
     }
+    const diagnostic = new vscode.Diagnostic(
+        new vscode.Range(0, 0, 0, 0),
+        message,
+        vscode.DiagnosticSeverity.Error,
+    );
+    diagnostic.source = 'Bittle compiler';
+    return {
+        fileName: document.fileName,
+        diagnostic,
+    };
 }
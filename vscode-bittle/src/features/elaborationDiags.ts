@@ -6,8 +6,12 @@ import { ReactiveCache } from '../utils/reactiveCache';
 import { stream } from '../utils/stream';
 import { toVscRange } from '../utils/vscode';
 
+// How long to wait after a change before elaborating the open files again
+const UPDATE_DELAY_MS = 150;
+
 export class ElaborationDiagnosticProvider implements vscode.Disposable {
     private diagnosticsCollection = vscode.languages.createDiagnosticCollection('Bittle');
+    private timer: ReturnType<typeof setTimeout> | undefined;
 
     constructor(
         private semanticsService: SemanticsService,
@@ -15,9 +19,17 @@ export class ElaborationDiagnosticProvider implements vscode.Disposable {
     ) { }
 
     dispose() {
+        clearTimeout(this.timer);
         this.diagnosticsCollection.dispose();
     }
 
+    // Coalesces the updates for a burst of changes, so that typing is not held
+    // up by elaborating after every keystroke, and other requests go first.
+    scheduleUpdate() {
+        clearTimeout(this.timer);
+        this.timer = setTimeout(() => this.updateDiagnostics(), UPDATE_DELAY_MS);
+    }
+
     @interceptExceptions
     updateDiagnostics() {
         const map = new Map<vscode.Uri, vscode.Diagnostic[] | undefined>();
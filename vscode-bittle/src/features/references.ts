@@ -3,29 +3,31 @@ import { SymReference } from '../semantics/elaborator';
 import { Sym } from '../semantics/sym';
 import { FileGraphService } from '../services/fileGraphService';
 import { ParsingService } from '../services/parsingService';
+import { ReferenceIndexService } from '../services/referenceIndexService';
 import { SemanticsService } from '../services/semanticsService';
 import { SyntaxNode } from '../syntax';
 import { NodeTypes } from '../syntax/nodeTypes';
-import { interceptExceptions } from '../utils/interceptExceptions';
+import { interceptExceptionsAsync } from '../utils/interceptExceptions';
 import { getIdentifierAtPosition } from '../utils/nodeSearch';
 import { stream } from '../utils/stream';
-import { fromVscPosition, toVscRange } from '../utils/vscode';
+import { fromVscPosition, toVscRange, yieldUnlessCancelled } from '../utils/vscode';
 
 export class ReferenceProvider implements vscode.ReferenceProvider, vscode.RenameProvider {
     constructor(
         private parsingService: ParsingService,
         private semanticsService: SemanticsService,
         private fileGraphService: FileGraphService,
+        private referenceIndex: ReferenceIndexService,
     ) { }
 
-    @interceptExceptions
-    provideRenameEdits(
+    @interceptExceptionsAsync
+    async provideRenameEdits(
         document: vscode.TextDocument,
         position: vscode.Position,
         newName: string,
-        _token: vscode.CancellationToken,
-    ): vscode.ProviderResult<vscode.WorkspaceEdit> {
-        const references = this.findReferences(document, position, { includeDeclaration: true });
+        token: vscode.CancellationToken,
+    ): Promise<vscode.WorkspaceEdit> {
+        const references = await this.findReferences(document, position, { includeDeclaration: true }, token);
 
         const workspaceEdit = new vscode.WorkspaceEdit();
         for (const reference of references) {
@@ -40,14 +42,14 @@ export class ReferenceProvider implements vscode.ReferenceProvider, vscode.Renam
         return workspaceEdit;
     }
 
-    @interceptExceptions
-    provideReferences(
+    @interceptExceptionsAsync
+    async provideReferences(
         document: vscode.TextDocument,
         vscPosition: vscode.Position,
         context: vscode.ReferenceContext,
-        _token: vscode.CancellationToken,
+        token: vscode.CancellationToken,
     ) {
-        const references = this.findReferences(document, vscPosition, context);
+        const references = await this.findReferences(document, vscPosition, context, token);
 
         return references
             .map(reference => new vscode.Location(
@@ -57,10 +59,14 @@ export class ReferenceProvider implements vscode.ReferenceProvider, vscode.Renam
             .toArray();
     }
 
-    private findReferences(
+    // Files that still have to be elaborated are looked at one per turn of the
+    // event loop, so that a search through a large workspace does not hold up
+    // other requests and can be cancelled.
+    private async findReferences(
         document: vscode.TextDocument,
         vscPosition: vscode.Position,
         context: vscode.ReferenceContext,
+        token: vscode.CancellationToken,
     ) {
         const path = document.uri.fsPath;
         const tree = this.parsingService.parse(path);
@@ -84,14 +90,13 @@ export class ReferenceProvider implements vscode.ReferenceProvider, vscode.Renam
                 );
             }
 
-            // add references in the same file
-            references.push(
-                ...this.semanticsService.references(path, symbol.qualifiedName),
-            );
-
-            // add references in referring files
-            for (const referringFile of this.findImportingFiles(symbol)) {
-                references.push(...this.semanticsService.references(referringFile, symbol.qualifiedName));
+            // add references in this file, the defining files, and the files
+            // importing them
+            for (const referringFile of this.findReferringFiles(path, symbol).toArray()) {
+                if (!this.referenceIndex.isIndexed(referringFile)) {
+                    await yieldUnlessCancelled(token);
+                }
+                references.push(...this.referenceIndex.references(referringFile, symbol.qualifiedName));
             }
         }
 
@@ -99,10 +104,25 @@ export class ReferenceProvider implements vscode.ReferenceProvider, vscode.Renam
             .distinctBy(reference => reference.file + '|' + reference.nameNode.startIndex);
     }
 
-    private findImportingFiles(symbol: Sym) {
+    // Uses the reference index to skip the files without references where it
+    // can, and otherwise looks at every file that could have them.
+    private findReferringFiles(path: string, symbol: Sym) {
+        const candidates = new Set([path, ...this.findDefiningFiles(symbol), ...this.findImportingFiles(symbol)]);
+        const indexed = this.referenceIndex.filesReferencing(symbol.qualifiedName);
+        if (!indexed) {
+            return stream(candidates);
+        }
+        return stream(indexed).filter(filePath => candidates.has(filePath));
+    }
+
+    private findDefiningFiles(symbol: Sym) {
         return stream(symbol.origins)
             .map(origin => origin.file)
-            .distinct()
+            .distinct();
+    }
+
+    private findImportingFiles(symbol: Sym) {
+        return this.findDefiningFiles(symbol)
             .flatMap(filePath => this.fileGraphService.getImportingFiles(filePath))
             .distinct();
     }
@@ -1,19 +1,21 @@
 import * as vscode from 'vscode';
 import { ParsingService } from '../services/parsingService';
+import { PersistentCache } from '../services/persistentCache';
 import { VirtualFileSystem } from '../services/vfs';
 import { SyntaxNode } from '../syntax';
 import { NodeTypes } from '../syntax/nodeTypes';
 import { fuzzySearch as searchFuzzy } from '../utils/fuzzySearch';
-import { interceptExceptions } from '../utils/interceptExceptions';
+import { interceptExceptions, interceptExceptionsAsync } from '../utils/interceptExceptions';
 import { ReactiveCache } from '../utils/reactiveCache';
 import { stream } from '../utils/stream';
-import { toVscRange } from '../utils/vscode';
+import { toVscRange, yieldUnlessCancelled } from '../utils/vscode';
 
 export class DocumentSymbolsProvider implements vscode.DocumentSymbolProvider, vscode.WorkspaceSymbolProvider {
     constructor(
         private parsingService: ParsingService,
         private vfs: VirtualFileSystem,
         private cache: ReactiveCache,
+        private persistentCache: PersistentCache,
     ) { }
 
     @interceptExceptions
@@ -21,8 +23,17 @@ export class DocumentSymbolsProvider implements vscode.DocumentSymbolProvider, v
         return this.getDocumentSymbols(document.uri.fsPath);
     }
 
-    @interceptExceptions
-    provideWorkspaceSymbols(query: string, token: vscode.CancellationToken): vscode.ProviderResult<vscode.SymbolInformation[]> {
+    @interceptExceptionsAsync
+    async provideWorkspaceSymbols(query: string, token: vscode.CancellationToken): Promise<vscode.SymbolInformation[]> {
+        // Parse the files that are not cached one at a time, so that the first
+        // search in a large workspace does not hold up everything else.
+        for (const file of this.vfs.listFiles()) {
+            if (this.cache.peek(`workspaceSymbols:${file}`) === undefined) {
+                this.getWorkspaceSymbolsForFile(file);
+                await yieldUnlessCancelled(token);
+            }
+        }
+
         const unfilteredSymbols = this.getUnfilteredWorkspaceSymbols();
         return searchFuzzy(query, unfilteredSymbols, { key: 'name' }).reverse(); // Reverse to show definitions before declarations.
     }
@@ -60,10 +71,20 @@ export class DocumentSymbolsProvider implements vscode.DocumentSymbolProvider, v
 
     private getWorkspaceSymbolsForFile(file: string): Iterable<vscode.SymbolInformation> {
         // Cached to avoid recomputing if another file in the file list is invalidated.
-        return this.cache.compute(`workspaceSymbols:${file}`, () =>
-            this.getDocumentSymbols(file)
-                .flatMap(symbol => fromDocumentSymbol(vscode.Uri.file(file), symbol)),
-        );
+        // Also kept across sessions, so that the first search does not have to
+        // parse the whole workspace.
+        return this.cache.compute(`workspaceSymbols:${file}`, () => {
+            const uri = vscode.Uri.file(file);
+            const text = this.vfs.readFile(file);
+            const stored = this.persistentCache.get<StoredSymbol[]>(file, 'workspaceSymbols', text);
+            if (stored) {
+                return stored.map(symbol => fromStoredSymbol(uri, symbol));
+            }
+            const symbols = this.getDocumentSymbols(file)
+                .flatMap(symbol => fromDocumentSymbol(uri, symbol));
+            this.persistentCache.set(file, 'workspaceSymbols', text, symbols.map(toStoredSymbol));
+            return symbols;
+        });
     }
 }
 
@@ -136,6 +157,32 @@ function fromDocumentSymbol(uri: vscode.Uri, symbol: DocumentSymbol, parent?: Do
     ];
 }
 
+type StoredSymbol = {
+    name: string;
+    kind: vscode.SymbolKind;
+    containerName: string;
+    range: [number, number, number, number];
+};
+
+function toStoredSymbol(symbol: vscode.SymbolInformation): StoredSymbol {
+    const { start, end } = symbol.location.range;
+    return {
+        name: symbol.name,
+        kind: symbol.kind,
+        containerName: symbol.containerName,
+        range: [start.line, start.character, end.line, end.character],
+    };
+}
+
+function fromStoredSymbol(uri: vscode.Uri, symbol: StoredSymbol): vscode.SymbolInformation {
+    return new vscode.SymbolInformation(
+        symbol.name,
+        symbol.kind,
+        symbol.containerName,
+        new vscode.Location(uri, new vscode.Range(...symbol.range)),
+    );
+}
+
 function isForwardDeclaration(node: SyntaxNode) {
     if (node.type === NodeTypes.FuncDecl || node.type === NodeTypes.RecordDecl) {
         return !node.childForFieldName('body');
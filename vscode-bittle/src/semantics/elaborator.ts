@@ -10,6 +10,7 @@ import { ReactiveCache } from '../utils/reactiveCache';
 import { stream } from '../utils/stream';
 import { ConstValue, ConstValueKind, mkIntConstValue } from './const';
 import { ConstEvaluator } from './constEvaluator';
+import { moduleInterface } from './moduleInterface';
 import { Scope } from './scope';
 import { ConstSym, EnumSym, FuncParamSym, FuncSym, GlobalSym, LocalSym, Origin, RecordFieldSym, RecordKind, RecordSym, Sym, SymKind } from './sym';
 import { canCoerce, isScalarType, isValidReturnType, mkArrayType, mkBoolType, mkEnumType, mkErrorType, mkIntType, mkNeverType, mkPointerType, mkRecordType, mkRestParamType, mkVoidType, prettyType, primitiveTypes, tryUnifyTypes, tryUnifyTypesWithCoercion, Type, typeCastable, typeEq, typeImplicitlyCastable, TypeKind, typeLayout } from './type';
@@ -121,6 +122,24 @@ export class Elaborator {
         );
     }
 
+    // Elaborates an imported module, but only depends on its interface, so that
+    // the importing module is reused while the interface stays the same.
+    private static elaborateImport(
+        parsingService: ParsingService,
+        pathResolver: PathResolver,
+        cache: ReactiveCache,
+        path: string,
+        importChain: string[],
+    ): ElaboratorResult {
+        const result = cache.untracked(() =>
+            Elaborator.elaborate(parsingService, pathResolver, cache, path, importChain),
+        );
+        cache.compute('module-interface:' + path, () =>
+            moduleInterface(Elaborator.elaborate(parsingService, pathResolver, cache, path, importChain)),
+        );
+        return result;
+    }
+
     //==============================================================================
     //== Scopes and Symbols
 
@@ -793,7 +812,7 @@ export class Elaborator {
             return;
         }
 
-        const elaboratorResult = Elaborator.elaborate(
+        const elaboratorResult = Elaborator.elaborateImport(
             this.parsingService,
             this.pathResolver,
             this.cache,
@@ -0,0 +1,71 @@
+import { SyntaxNode } from '../syntax';
+import { TokenNodeImpl } from '../syntax/treeImpl';
+import { unreachable } from '../utils';
+import type { ElaboratorResult } from './elaborator';
+import { Origin, prettySym, Sym, SymKind } from './sym';
+
+/**
+ * Describes everything that a module shows to the modules importing it: the
+ * names in its root scope and the symbols they refer to, including where they
+ * are declared and their doc comments.
+ *
+ * Importers are only elaborated again when this changes, so that an edit
+ * inside a function body does not invalidate the modules importing the file.
+ * They then keep the symbols of the earlier elaboration, which are the same as
+ * far as they can tell.
+ */
+export function moduleInterface(module: ElaboratorResult): string {
+    const lines: string[] = [`module ${module.moduleName ?? ''}`];
+    for (const [name, qname] of module.rootScope.symbols) {
+        const sym = module.symbols.get(qname);
+        lines.push(`${name} = ${qname}`);
+        if (sym) {
+            describeSym(sym, lines);
+        }
+    }
+    return lines.join('\n');
+}
+
+function describeSym(sym: Sym, lines: string[]) {
+    lines.push(`  ${prettySym(sym)}${sym.isDefined ? ' defined' : ''}`);
+    for (const origin of sym.origins) {
+        lines.push(`  at ${describeOrigin(origin)}`);
+    }
+
+    if (sym.kind === SymKind.Record) {
+        lines.push(`  base ${sym.base?.qualifiedName ?? ''}`);
+        for (const field of sym.fields) {
+            describeSym(field, lines);
+        }
+    } else if (sym.kind === SymKind.Func) {
+        for (const param of sym.params) {
+            describeSym(param, lines);
+        }
+    } else if (sym.kind === SymKind.Enum) {
+        lines.push(`  size ${sym.size}`);
+    } else if (
+        sym.kind === SymKind.RecordField
+        || sym.kind === SymKind.FuncParam
+        || sym.kind === SymKind.Global
+        || sym.kind === SymKind.Const
+        || sym.kind === SymKind.Local
+    ) {
+        // Fully described by prettySym
+    } else {
+        unreachable(sym);
+    }
+}
+
+function describeOrigin(origin: Origin): string {
+    const range = (node: SyntaxNode) =>
+        `${node.startPosition.row}:${node.startPosition.column}-${node.endPosition.row}:${node.endPosition.column}`;
+    const nameRange = origin.nameNode ? range(origin.nameNode) : '';
+    const forward = origin.isForwardDecl ? ' forward' : '';
+    return `${origin.file} ${range(origin.node)} ${nameRange}${forward} ${JSON.stringify(leadingTrivia(origin.node))}`;
+}
+
+// Where the doc comment of a declaration is
+function leadingTrivia(node: SyntaxNode): string {
+    const firstNode = node.descendantForPosition(node.startPosition);
+    return firstNode instanceof TokenNodeImpl ? firstNode.token.leadingTrivia.join('') : '';
+}
@@ -1,31 +1,91 @@
 import assert from 'assert';
+import type { ChildProcessWithoutNullStreams } from 'child_process';
 import { spawn } from 'child_process';
+import * as readline from 'readline';
 import * as vscode from 'vscode';
 import { log } from '../log';
-import { unreachable } from '../utils';
 
-export class CompilerService {
-    async compile(filePath: string) {
+// How long a check may take before the compiler is given up on
+const CHECK_TIMEOUT_MS = 1000;
+
+/** An error as reported by `bittlec --check`. */
+export type CompilerError = {
+    file: string | null;
+    // 1-based, or 0 if the error has no position
+    line: number;
+    column: number;
+    message: string;
+};
+
+export type CheckResult = {
+    exitCode: number;
+    errors: CompilerError[];
+    // Anything the compiler wrote besides the errors, such as a crash report
+    stderr: string;
+};
+
+type Request = {
+    resolve: (result: CheckResult) => void;
+    reject: (error: Error) => void;
+    errors: CompilerError[];
+};
+
+export class CompilerService implements vscode.Disposable {
+    private server: CompilerServer | undefined;
+
+    dispose() {
+        this.server?.dispose();
+    }
+
+    /**
+     * Checks a file and the files it imports without emitting anything. Uses
+     * a resident compiler if `bittle.compilerServer` is set, which keeps the
+     * unchanged modules loaded between checks.
+     */
+    async check(filePath: string): Promise<CheckResult> {
         log.log(`Invoking compiler for ${filePath}`);
 
-        const bittlec = vscode.workspace.getConfiguration().get<string>('bittle.compilerPath', 'bittlec');
+        const config = vscode.workspace.getConfiguration();
+        const bittlec = config.get<string>('bittle.compilerPath', 'bittlec');
+
+        if (!config.get<boolean>('bittle.compilerServer', false)) {
+            this.server?.dispose();
+            this.server = undefined;
+            return this.checkOnce(bittlec, filePath);
+        }
+
+        if (this.server?.bittlec !== bittlec || !this.server.isRunning) {
+            this.server?.dispose();
+            this.server = new CompilerServer(bittlec);
+        }
+        return this.server.check(filePath);
+    }
 
+    private async checkOnce(bittlec: string, filePath: string): Promise<CheckResult> {
         const process = spawn(
             bittlec,
-            [filePath],
+            ['--check', filePath],
             {
-                stdio: ['ignore', 'ignore', 'pipe'],
-                timeout: 1000,
+                stdio: ['ignore', 'pipe', 'pipe'],
+                timeout: CHECK_TIMEOUT_MS,
             },
         );
 
+        const errors: CompilerError[] = [];
+        readline.createInterface({ input: process.stdout }).on('line', line => {
+            const error = parseError(line);
+            if (error) {
+                errors.push(error);
+            }
+        });
+
         let stderr = '';
         process.stderr.on('data', data => {
             stderr += data.toString();
         });
 
         const code = await new Promise<number>((resolve, reject) => {
-            process.on('exit', (code, signal) => {
+            process.on('close', (code, signal) => {
                 if (signal) {
                     log.log(`Compiler killed by signal ${signal}`);
                     reject(new Error('Compiler killed by signal ' + signal));
@@ -42,6 +102,118 @@ export class CompilerService {
         });
         log.log(`Compiler exited with code ${code}`);
 
-        return { exitCode: code, stderr };
+        return { exitCode: code, errors, stderr };
+    }
+}
+
+/**
+ * A `bittlec --server` process, which checks one file at a time. The process
+ * is started on creation and is not restarted; a new server is created in its
+ * place once it has exited.
+ */
+class CompilerServer implements vscode.Disposable {
+    private process: ChildProcessWithoutNullStreams;
+    private requests: Request[] = [];
+    private stderr = '';
+    private timer: ReturnType<typeof setTimeout> | undefined;
+    isRunning = true;
+
+    constructor(readonly bittlec: string) {
+        log.log(`Starting compiler server ${bittlec}`);
+        this.process = spawn(bittlec, ['--server']);
+        readline.createInterface({ input: this.process.stdout }).on('line', line => this.onLine(line));
+        this.process.stderr.on('data', data => {
+            this.stderr += data.toString();
+        });
+        this.process.on('close', (code, signal) => {
+            this.stop(new Error(`Compiler server exited (${signal ?? code})`));
+        });
+        this.process.on('error', error => {
+            this.stop(new Error('Error invoking compiler: ' + error));
+        });
+        this.process.stdin.on('error', error => {
+            this.stop(new Error('Error writing to compiler server: ' + error));
+        });
+    }
+
+    dispose() {
+        this.stop(new Error('Compiler server stopped'));
+    }
+
+    check(filePath: string): Promise<CheckResult> {
+        return new Promise((resolve, reject) => {
+            this.requests.push({ resolve, reject, errors: [] });
+            this.process.stdin.write(filePath + '\n');
+            if (this.requests.length === 1) {
+                this.startTimer();
+            }
+        });
+    }
+
+    private onLine(line: string) {
+        const request = this.requests[0];
+        if (!request) {
+            return;
+        }
+        const error = parseError(line);
+        if (error) {
+            request.errors.push(error);
+        } else if (isDone(line)) {
+            this.requests.shift();
+            clearTimeout(this.timer);
+            if (this.requests.length > 0) {
+                this.startTimer();
+            }
+            const exitCode = request.errors.length > 0 ? 1 : 0;
+            request.resolve({ exitCode, errors: request.errors, stderr: this.stderr });
+            this.stderr = '';
+        }
+    }
+
+    // A check that does not finish in time takes the server down with it,
+    // since there is no telling the rest of its output apart from the next.
+    private startTimer() {
+        this.timer = setTimeout(() => {
+            log.log('Compiler server timed out');
+            this.stop(new Error('Compiler server timed out'));
+        }, CHECK_TIMEOUT_MS);
+    }
+
+    private stop(error: Error) {
+        if (this.isRunning) {
+            log.log(error.message);
+        }
+        this.isRunning = false;
+        clearTimeout(this.timer);
+        this.process.kill();
+        for (const request of this.requests.splice(0)) {
+            request.reject(error);
+        }
+    }
+}
+
+function parseError(line: string): CompilerError | undefined {
+    const value = parseJson(line);
+    if (typeof value?.message !== 'string') {
+        return undefined;
+    }
+    return {
+        file: typeof value.file === 'string' ? value.file : null,
+        line: typeof value.line === 'number' ? value.line : 0,
+        column: typeof value.column === 'number' ? value.column : 0,
+        message: value.message,
+    };
+}
+
+function isDone(line: string): boolean {
+    return parseJson(line)?.done === true;
+}
+
+function parseJson(line: string): Record<string, unknown> | undefined {
+    try {
+        const value: unknown = JSON.parse(line);
+        return typeof value === 'object' && value !== null ? value as Record<string, unknown> : undefined;
+    } catch {
+        return undefined;
     }
 }
@@ -1,69 +1,131 @@
-import { Tree } from '../syntax';
-import { DeclNodeTypes } from '../syntax/generated';
-import { NodeTypes, TopLevelNodeTypes } from '../syntax/nodeTypes';
+import { NodeTypes } from '../syntax/nodeTypes';
+import { arrayEq } from '../utils';
+import { parseString } from '../utils/literalParsing';
+import { ReactiveCache } from '../utils/reactiveCache';
 import { ParsingService } from './parsingService';
 import { PathResolver } from './pathResolver';
+import { PersistentCache } from './persistentCache';
 import { VirtualFileSystem } from './vfs';
 
 type FileGraph = {
     incoming: Map<string, Set<string>>;
-    outgoing: Map<string, Set<string>>;
+    outgoing: Map<string, string[]>;
 };
 
+/**
+ * The import graph of the workspace. The imports of each file are cached on
+ * their own, so an edit only recomputes the edges of the edited file, and the
+ * graph is then updated for the files whose imports changed.
+ */
 export class FileGraphService {
+    // The graph computed last, which the next one is updated from
+    private lastGraph: FileGraph = { incoming: new Map(), outgoing: new Map() };
+
     constructor(
         private parsingService: ParsingService,
         private vfs: VirtualFileSystem,
         private pathResolver: PathResolver,
+        private cache: ReactiveCache,
+        private persistentCache: PersistentCache,
     ) { }
 
     getImportingFiles(filePath: string): string[] {
-        const importGraph = this.getFileGraph(path => {
-            const tree = this.parsingService.parse(path);
-            return this.getReferencesForFile(path, tree, NodeTypes.ImportDecl);
-        });
-        return Array.from(importGraph.incoming.get(filePath) ?? []);
+        const graph = this.getFileGraph();
+        return Array.from(graph.incoming.get(filePath) ?? []);
     }
 
-    private getFileGraph(getOutgoing: (path: string) => Set<string>): FileGraph {
-        const filePaths = this.vfs.listFiles();
+    getImportedFiles(filePath: string): string[] {
+        return this.cache.compute(
+            `imports:${filePath}`,
+            () => Array.from(this.getImportedFilesUncached(filePath)),
+            arrayEq,
+        );
+    }
 
-        const outgoing = new Map<string, Set<string>>();
-        const incoming = new Map<string, Set<string>>();
+    private getFileGraph(): FileGraph {
+        return this.cache.compute(`fileGraph`, () => {
+            this.lastGraph = this.updateFileGraph(this.lastGraph);
+            return this.lastGraph;
+        });
+    }
 
-        for (const filePath of filePaths) {
-            outgoing.set(filePath, new Set());
-            incoming.set(filePath, new Set());
-        }
+    // Takes over the maps of the old graph, which must not be used afterwards.
+    private updateFileGraph(old: FileGraph): FileGraph {
+        const filePaths = new Set(this.vfs.listFiles());
+        const { incoming, outgoing } = old;
 
-        for (const filePath of filePaths) {
-            outgoing.set(filePath, getOutgoing(filePath));
+        for (const [filePath, imports] of outgoing) {
+            if (!filePaths.has(filePath)) {
+                removeEdges(incoming, filePath, imports);
+                outgoing.delete(filePath);
+                incoming.delete(filePath);
+            }
         }
 
-        for (const [filePath, references] of outgoing) {
-            for (const reference of references) {
-                incoming.get(reference)!.add(filePath);
+        for (const filePath of filePaths) {
+            const oldImports = outgoing.get(filePath) ?? [];
+            const imports = this.getImportedFiles(filePath);
+            if (!arrayEq(imports, oldImports)) {
+                removeEdges(incoming, filePath, oldImports);
+                addEdges(incoming, filePath, imports);
             }
+            outgoing.set(filePath, imports);
         }
 
         return { incoming, outgoing };
     }
 
-    private getReferencesForFile(path: string, tree: Tree, type: string): Set<string> {
-        const references = new Set<string>();
+    private* getImportedFilesUncached(path: string): Iterable<string> {
+        const seen = new Set<string>();
 
+        for (const specifier of this.getImportSpecifiers(path)) {
+            const importPath = this.pathResolver.resolveImport(path, specifier);
+            if (importPath && !seen.has(importPath)) {
+                seen.add(importPath);
+                yield importPath;
+            }
+        }
+    }
+
+    // The import paths as written, which are kept across sessions. Resolving
+    // them depends on other files, so that is done afresh.
+    private getImportSpecifiers(path: string): string[] {
+        const text = this.vfs.readFile(path);
+        const stored = this.persistentCache.get<string[]>(path, 'imports', text);
+        if (stored) {
+            return stored;
+        }
+
+        const tree = this.parsingService.parse(path);
+        const specifiers: string[] = [];
         for (const node of tree.rootNode.children) {
-            if (type) {
+            if (node.type === NodeTypes.ImportDecl) {
                 const pathNode = node.childForFieldName('path');
-                if (pathNode) {
-                    const reference = this.pathResolver.resolveImport(path, pathNode);
-                    if (reference) {
-                        references.add(reference);
-                    }
+                const specifier = pathNode && parseString(pathNode.text);
+                if (specifier) {
+                    specifiers.push(specifier);
                 }
             }
         }
 
-        return references;
+        this.persistentCache.set(path, 'imports', text, specifiers);
+        return specifiers;
+    }
+}
+
+function addEdges(incoming: Map<string, Set<string>>, from: string, to: string[]) {
+    for (const target of to) {
+        let set = incoming.get(target);
+        if (!set) {
+            set = new Set();
+            incoming.set(target, set);
+        }
+        set.add(from);
+    }
+}
+
+function removeEdges(incoming: Map<string, Set<string>>, from: string, to: string[]) {
+    for (const target of to) {
+        incoming.get(target)?.delete(from);
     }
 }
@@ -1,6 +1,7 @@
 import { NodeTypes } from '../syntax/nodeTypes';
 import { ReactiveCache } from '../utils/reactiveCache';
 import { ParsingService } from './parsingService';
+import { PersistentCache } from './persistentCache';
 import { VirtualFileSystem } from './vfs';
 
 export class ModuleListService {
@@ -8,22 +9,28 @@ export class ModuleListService {
         private parsingService: ParsingService,
         private vfs: VirtualFileSystem,
         private cache: ReactiveCache,
+        private persistentCache: PersistentCache,
     ) { }
 
     getModuleList(): string[] {
         return this.cache.compute(`moduleList`, () => {
-            return Array.from(this.getModuleListUncached());
+            return this.vfs.listFiles().filter(filePath => this.isModule(filePath));
         });
     }
 
-    private* getModuleListUncached(): Iterable<string> {
-        for (const filePath of this.vfs.listFiles()) {
-            const tree = this.parsingService.parse(filePath);
-            for (const node of tree.rootNode.children) {
-                if (node.type === NodeTypes.ModuleNameDecl) {
-                    yield filePath;
-                }
+    // Also kept across sessions, so that the list does not need every file
+    // parsed at startup.
+    private isModule(filePath: string): boolean {
+        return this.cache.compute(`isModule:${filePath}`, () => {
+            const text = this.vfs.readFile(filePath);
+            const stored = this.persistentCache.get<boolean>(filePath, 'isModule', text);
+            if (stored !== undefined) {
+                return stored;
             }
-        }
+            const tree = this.parsingService.parse(filePath);
+            const isModule = tree.rootNode.children.some(node => node.type === NodeTypes.ModuleNameDecl);
+            this.persistentCache.set(filePath, 'isModule', text, isModule);
+            return isModule;
+        });
     }
 }
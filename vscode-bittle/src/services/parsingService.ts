@@ -1,13 +1,9 @@
-import { Error, Parser, tokenize, Tree } from '../syntax';
+import { Error, Tree } from '../syntax';
 import { RootNode } from '../syntax/generated';
+import { parse, ParseResult, reparse } from '../syntax/reparser';
 import { ReactiveCache } from '../utils/reactiveCache';
 import { VirtualFileSystem } from './vfs';
 
-interface ParseResult {
-    tree: Tree;
-    errors: Error[];
-}
-
 export interface ParsingService {
     parse(path: string): Tree;
     parseAsAst(path: string): RootNode;
@@ -15,6 +11,9 @@ export interface ParsingService {
 }
 
 export class ParsingServiceImpl implements ParsingService {
+    // The last parse of each file, to reparse from after an edit
+    private previous = new Map<string, ParseResult>();
+
     constructor(
         private cache: ReactiveCache,
         private vfs: VirtualFileSystem,
@@ -40,14 +39,16 @@ export class ParsingServiceImpl implements ParsingService {
 
     private runParserUncached(path: string): ParseResult {
         const text = this.vfs.readFile(path);
+        const change = this.vfs.lastChange(path);
+        const previous = this.previous.get(path);
 
-        const errors: Error[] = [];
-        const errorSink = {
-            add: (error: Error) => errors.push(error),
-        };
-
-        const tree = new Parser(text, tokenize(text, errorSink), errorSink).top();
+        const result = previous && change
+            && change.oldText === previous.tree.text
+            && text.length - change.oldText.length === change.change.newEndIndex - change.change.oldEndIndex
+            ? reparse(previous, text, change.change)
+            : parse(text);
 
-        return { tree, errors };
+        this.previous.set(path, result);
+        return result;
     }
 }
@@ -0,0 +1,152 @@
+import { createHash } from 'crypto';
+import * as fs from 'fs';
+import path from 'path';
+import * as vscode from 'vscode';
+import { log } from '../log';
+
+// Bumped whenever the shape of a stored result changes
+const FORMAT_VERSION = 1;
+// How long to wait after the last new result before writing the cache
+const SAVE_DELAY_MS = 2000;
+
+type FileEntry = {
+    hash: string;
+    // Kind -> Result
+    results: Record<string, unknown>;
+};
+
+type CacheFile = {
+    version: string;
+    files: Record<string, FileEntry>;
+};
+
+/**
+ * Results of per-file analyses kept across sessions, in the workspace storage
+ * of the extension.
+ *
+ * Each file's results are stored with a hash of the content they were computed
+ * from, and are only handed out for the same content, so the cache is
+ * validated lazily by the lookups themselves. Only results that are plain
+ * data and depend on nothing but the content of their file belong here.
+ */
+export class PersistentCache implements vscode.Disposable {
+    private files: Map<string, FileEntry> | undefined;
+    // The last hash computed for each file, with the text it was computed from
+    private hashes = new Map<string, { text: string; hash: string }>();
+    private isDirty = false;
+    private timer: ReturnType<typeof setTimeout> | undefined;
+
+    constructor(
+        private storageDir: string | undefined,
+        private extensionVersion: string,
+    ) { }
+
+    dispose() {
+        clearTimeout(this.timer);
+        if (this.isDirty) {
+            this.saveSync();
+        }
+    }
+
+    /** The result of the given kind stored for the file, if it was computed from `text`. */
+    get<T>(filePath: string, kind: string, text: string): T | undefined {
+        const entry = this.load().get(filePath);
+        if (!entry || entry.hash !== this.hash(filePath, text)) {
+            return undefined;
+        }
+        return entry.results[kind] as T | undefined;
+    }
+
+    /** Stores the result of the given kind for the file, computed from `text`. */
+    set<T>(filePath: string, kind: string, text: string, result: T) {
+        if (!this.storageDir) {
+            return;
+        }
+        const files = this.load();
+        const hash = this.hash(filePath, text);
+        let entry = files.get(filePath);
+        if (!entry || entry.hash !== hash) {
+            entry = { hash, results: {} };
+            files.set(filePath, entry);
+        }
+        entry.results[kind] = result;
+        this.scheduleSave();
+    }
+
+    private hash(filePath: string, text: string): string {
+        const cached = this.hashes.get(filePath);
+        if (cached?.text === text) {
+            return cached.hash;
+        }
+        const hash = createHash('sha1').update(text).digest('base64');
+        this.hashes.set(filePath, { text, hash });
+        return hash;
+    }
+
+    private get cachePath(): string | undefined {
+        return this.storageDir && path.join(this.storageDir, 'analysis-cache.json');
+    }
+
+    private get version(): string {
+        return `${FORMAT_VERSION}:${this.extensionVersion}`;
+    }
+
+    private load(): Map<string, FileEntry> {
+        if (this.files) {
+            return this.files;
+        }
+        this.files = new Map();
+        if (!this.cachePath || !fs.existsSync(this.cachePath)) {
+            return this.files;
+        }
+        try {
+            const cacheFile = JSON.parse(fs.readFileSync(this.cachePath, 'utf8')) as CacheFile;
+            if (cacheFile.version === this.version) {
+                this.files = new Map(Object.entries(cacheFile.files));
+            }
+            log.log(`Loaded ${this.files.size} files from the analysis cache`);
+        } catch (error) {
+            log.log('Ignoring unreadable analysis cache', error);
+        }
+        return this.files;
+    }
+
+    private scheduleSave() {
+        this.isDirty = true;
+        clearTimeout(this.timer);
+        this.timer = setTimeout(() => {
+            this.save().catch(error => log.log('Failed to write the analysis cache', error));
+        }, SAVE_DELAY_MS);
+    }
+
+    private async save() {
+        const contents = this.serialize();
+        this.isDirty = false;
+        await fs.promises.mkdir(this.storageDir!, { recursive: true });
+        await fs.promises.writeFile(this.cachePath!, contents);
+    }
+
+    // Used when the extension is deactivated, when there is no time to wait.
+    private saveSync() {
+        try {
+            const contents = this.serialize();
+            this.isDirty = false;
+            fs.mkdirSync(this.storageDir!, { recursive: true });
+            fs.writeFileSync(this.cachePath!, contents);
+        } catch (error) {
+            log.log('Failed to write the analysis cache', error);
+        }
+    }
+
+    // Leaves out the files that are gone, so the cache does not keep growing.
+    private serialize(): string {
+        const files: Record<string, FileEntry> = {};
+        for (const [filePath, entry] of this.load()) {
+            if (this.hashes.has(filePath) || fs.existsSync(filePath)) {
+                files[filePath] = entry;
+            }
+        }
+        const cacheFile: CacheFile = { version: this.version, files };
+        return JSON.stringify(cacheFile);
+    }
+}
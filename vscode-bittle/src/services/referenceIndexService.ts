@@ -0,0 +1,160 @@
+import * as vscode from 'vscode';
+import { log } from '../log';
+import { SymReference } from '../semantics/elaborator';
+import { ReactiveCache } from '../utils/reactiveCache';
+import { SemanticsService } from './semanticsService';
+import { VirtualFileSystem } from './vfs';
+
+// How long the workspace has to be quiet before the index is brought up to date
+const INDEX_DELAY_MS = 500;
+
+type ReferenceIndex = {
+    // Path -> Symbol.qualifiedName -> Reference[]
+    files: Map<string, Map<string, SymReference[]>>;
+    // Symbol.qualifiedName -> Paths that refer to it
+    names: Map<string, Set<string>>;
+};
+
+/**
+ * An index from qualified names to the files that refer to them, across the
+ * whole workspace.
+ *
+ * The references of each file are cached on their own and come from its
+ * elaboration. The index is built in the background after activation and
+ * after every change, one file at a time, and is updated from the previous
+ * one for the files whose references were invalidated. While it is not up to
+ * date, lookups fall back to the caller.
+ */
+export class ReferenceIndexService implements vscode.Disposable {
+    private disposables: vscode.Disposable[] = [];
+    // The index computed last, which the next one is updated from
+    private lastIndex: ReferenceIndex = { files: new Map(), names: new Map() };
+    private timer: ReturnType<typeof setTimeout> | undefined;
+    // Bumped on every change to cancel the build in progress
+    private generation = 0;
+
+    constructor(
+        private semanticsService: SemanticsService,
+        private vfs: VirtualFileSystem,
+        private cache: ReactiveCache,
+    ) {
+        this.vfs.onDidChangeFile(() => this.scheduleBuild(), this, this.disposables);
+        this.scheduleBuild();
+    }
+
+    dispose() {
+        clearTimeout(this.timer);
+        this.generation++;
+        this.disposables.forEach(d => {
+            d.dispose();
+        });
+    }
+
+    /**
+     * The files that refer to the symbol, or undefined if the index is not up
+     * to date.
+     */
+    filesReferencing(qname: string): string[] | undefined {
+        const index = this.cache.peek<ReferenceIndex>(`referenceIndex`);
+        if (!index) {
+            return undefined;
+        }
+        return Array.from(index.names.get(qname) ?? []);
+    }
+
+    /** Whether the references of a file are known without elaborating it. */
+    isIndexed(path: string): boolean {
+        return this.cache.peek(`fileReferences:${path}`) !== undefined;
+    }
+
+    /** The references to the symbol in a file, elaborating it if needed. */
+    references(path: string, qname: string): SymReference[] {
+        return this.fileReferences(path).get(qname) ?? [];
+    }
+
+    private fileReferences(path: string): Map<string, SymReference[]> {
+        return this.cache.compute(`fileReferences:${path}`, () =>
+            this.semanticsService.referencesByName(path),
+        );
+    }
+
+    private getIndex(): ReferenceIndex {
+        return this.cache.compute(`referenceIndex`, () => {
+            this.lastIndex = this.updateIndex(this.lastIndex);
+            return this.lastIndex;
+        });
+    }
+
+    // Takes over the maps of the old index, which must not be used afterwards.
+    private updateIndex(old: ReferenceIndex): ReferenceIndex {
+        const filePaths = new Set(this.vfs.listFiles());
+        const { files, names } = old;
+
+        for (const [filePath, references] of files) {
+            if (!filePaths.has(filePath)) {
+                removeNames(names, filePath, references);
+                files.delete(filePath);
+            }
+        }
+
+        for (const filePath of filePaths) {
+            const oldReferences = files.get(filePath);
+            const references = this.fileReferences(filePath);
+            if (references !== oldReferences) {
+                if (oldReferences) {
+                    removeNames(names, filePath, oldReferences);
+                }
+                addNames(names, filePath, references);
+                files.set(filePath, references);
+            }
+        }
+
+        return { files, names };
+    }
+
+    private scheduleBuild() {
+        this.generation++;
+        clearTimeout(this.timer);
+        this.timer = setTimeout(() => {
+            this.build(this.generation).catch(error => log.log(error));
+        }, INDEX_DELAY_MS);
+    }
+
+    // Elaborates the files one at a time, giving way to other work in
+    // between, and stops early if anything changes meanwhile.
+    private async build(generation: number) {
+        const startTime = Date.now();
+        for (const filePath of this.vfs.listFiles()) {
+            if (generation !== this.generation) {
+                return;
+            }
+            this.fileReferences(filePath);
+            await new Promise(resolve => setImmediate(resolve));
+        }
+        if (generation === this.generation) {
+            this.getIndex();
+            log.log(`Reference index updated in ${Date.now() - startTime}ms`);
+        }
+    }
+}
+
+function addNames(names: Map<string, Set<string>>, filePath: string, references: Map<string, SymReference[]>) {
+    for (const qname of references.keys()) {
+        let set = names.get(qname);
+        if (!set) {
+            set = new Set();
+            names.set(qname, set);
+        }
+        set.add(filePath);
+    }
+}
+
+function removeNames(names: Map<string, Set<string>>, filePath: string, references: Map<string, SymReference[]>) {
+    for (const qname of references.keys()) {
+        const set = names.get(qname);
+        set?.delete(filePath);
+        if (set?.size === 0) {
+            names.delete(qname);
+        }
+    }
+}
@@ -97,6 +97,10 @@ export class SemanticsService {
         return module.references.get(qname) ?? [];
     }
 
+    public referencesByName(path: string): Map<string, SymReference[]> {
+        return this.elaborateFile(path).references;
+    }
+
     private elaborateFile(path: string): ElaboratorResult {
         return Elaborator.elaborate(this.parsingService, this.pathResolver, this.cache, path);
     }
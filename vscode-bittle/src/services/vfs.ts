@@ -3,7 +3,8 @@ import { Minimatch } from 'minimatch';
 import path from 'path';
 import * as vscode from 'vscode';
 import { log } from '../log';
-import { isBittleFile } from '../utils';
+import { composeTextChanges, TextChange } from '../syntax/reparser';
+import { arrayEq, isBittleFile } from '../utils';
 import { ReactiveCache } from '../utils/reactiveCache';
 
 /** A virtual file system that keeps files in with changes in memory. */
@@ -14,12 +15,31 @@ export interface VirtualFileSystem {
     exists(path: string): boolean;
     /** List all files in the virtual file system */
     listFiles(): string[];
+    /**
+     * The edit that turned the previously read content of a file into the
+     * current one, if it is known.
+     */
+    lastChange(path: string): FileChange | undefined;
+    /** Fires with the path of a file whose content or existence changed */
+    readonly onDidChangeFile: vscode.Event<string>;
+}
+
+export interface FileChange {
+    oldText: string;
+    change: TextChange;
 }
 
 export class VirtualFileSystemImpl implements VirtualFileSystem, vscode.Disposable {
     private disposables: vscode.Disposable[] = [];
     private cache: ReactiveCache;
     private excludes: Minimatch[] = [];
+    // The last content read for each file, the edits to it since (null if
+    // unknown), and the edit between the last two reads
+    private texts = new Map<string, string>();
+    private pendingChanges = new Map<string, TextChange | null>();
+    private lastChanges = new Map<string, FileChange>();
+    private onDidChangeFileEmitter = new vscode.EventEmitter<string>();
+    public readonly onDidChangeFile = this.onDidChangeFileEmitter.event;
 
     constructor(cache: ReactiveCache) {
         this.cache = cache;
@@ -33,6 +53,13 @@ export class VirtualFileSystemImpl implements VirtualFileSystem, vscode.Disposab
                 return;
 
             const path = event.document.uri.fsPath;
+            for (const contentChange of event.contentChanges) {
+                this.recordChange(path, {
+                    startIndex: contentChange.rangeOffset,
+                    oldEndIndex: contentChange.rangeOffset + contentChange.rangeLength,
+                    newEndIndex: contentChange.rangeOffset + contentChange.text.length,
+                });
+            }
             this.invalidateContents(path);
         }, this.disposables);
 
@@ -43,6 +70,7 @@ export class VirtualFileSystemImpl implements VirtualFileSystem, vscode.Disposab
             }
 
             const path = uri.fsPath;
+            this.pendingChanges.set(path, null);
             this.invalidateContents(path);
         });
         watcher.onDidDelete((uri) => {
@@ -54,7 +82,7 @@ export class VirtualFileSystemImpl implements VirtualFileSystem, vscode.Disposab
             this.invalidateFile(path);
         });
 
-        this.disposables.push(watcher);
+        this.disposables.push(watcher, this.onDidChangeFileEmitter);
     }
 
     public dispose() {
@@ -63,14 +91,30 @@ export class VirtualFileSystemImpl implements VirtualFileSystem, vscode.Disposab
         });
     }
 
+    // Changes within an event apply one after the other, so they compose with
+    // each other just like with those of earlier events.
+    private recordChange(path: string, change: TextChange) {
+        if (!this.texts.has(path)) {
+            return;
+        }
+        const pending = this.pendingChanges.get(path);
+        if (pending === null) {
+            return;
+        }
+        this.pendingChanges.set(path, pending ? composeTextChanges(pending, change) : change);
+    }
+
     private invalidateContents(path: string) {
-        this.cache.delete(`vfs:read:${path}`);
+        this.cache.invalidate(`vfs:read:${path}`);
+        this.onDidChangeFileEmitter.fire(path);
     }
 
     private invalidateFile(path: string) {
-        this.cache.delete(`vfs:list`);
-        this.cache.delete(`vfs:read:${path}`);
-        this.cache.delete(`vfs:exists:${path}`);
+        this.pendingChanges.set(path, null);
+        this.cache.invalidate(`vfs:list`);
+        this.cache.invalidate(`vfs:read:${path}`);
+        this.cache.invalidate(`vfs:exists:${path}`);
+        this.onDidChangeFileEmitter.fire(path);
     }
 
     public readFile(path: string): string {
@@ -82,11 +126,27 @@ export class VirtualFileSystemImpl implements VirtualFileSystem, vscode.Disposab
     }
 
     public listFiles(): string[] {
-        return this.cache.compute(`vfs:list`, () => Array.from(this.listFilesUncached()));
+        return this.cache.compute(`vfs:list`, () => Array.from(this.listFilesUncached()), arrayEq);
+    }
+
+    public lastChange(path: string): FileChange | undefined {
+        return this.lastChanges.get(path);
     }
 
     private readFileUncached(path: string): string {
-        return getFromWorkspace() ?? getFromFileSystem() ?? '';
+        const text = getFromWorkspace() ?? getFromFileSystem() ?? '';
+
+        const oldText = this.texts.get(path);
+        const change = this.pendingChanges.get(path);
+        if (oldText !== undefined && change) {
+            this.lastChanges.set(path, { oldText, change });
+        } else {
+            this.lastChanges.delete(path);
+        }
+        this.texts.set(path, text);
+        this.pendingChanges.delete(path);
+
+        return text;
 
         function getFromWorkspace(): string | undefined {
             return vscode.workspace.textDocuments
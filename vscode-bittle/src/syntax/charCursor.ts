@@ -1,12 +1,18 @@
 import assert from 'assert';
-import { Point } from './position';
+import { Point, TextOffset } from './position';
 
 export class CharCursor {
     private _row: number = 0;
     private _col: number = 0;
     private _index: number = 0;
 
-    constructor(private text: string) { }
+    constructor(private text: string, start?: TextOffset) {
+        if (start) {
+            this._row = start.position.row;
+            this._col = start.position.column;
+            this._index = start.index;
+        }
+    }
 
     get cc() {
         assert(!this.isEof);
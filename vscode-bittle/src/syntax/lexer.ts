@@ -2,11 +2,12 @@ import assert from 'assert';
 import { unreachable } from '../utils/index.js';
 import { CharCursor } from './charCursor.js';
 import { ErrorSink } from './errorSink.js';
-import { Point } from './position';
+import { Point, TextOffset } from './position';
 import { keywords, symbols, Token, TokenKind } from './token.js';
 
-export function* tokenize(text: string, errorSink: ErrorSink): Generator<Token, Token> {
-    const lexer = new Lexer(text, errorSink);
+/** Tokenizes the text, or the part of it from `start`, which must be a token boundary. */
+export function* tokenize(text: string, errorSink: ErrorSink, start?: TextOffset): Generator<Token, Token> {
+    const lexer = new Lexer(text, errorSink, start);
     while (true) {
         yield lexer.scanToken();
     }
@@ -18,8 +19,8 @@ export class Lexer {
     private cursor: CharCursor;
     private trivia: string[] = [];
 
-    constructor(private text: string, private errors: ErrorSink) {
-        this.cursor = new CharCursor(text);
+    constructor(private text: string, private errors: ErrorSink, start?: TextOffset) {
+        this.cursor = new CharCursor(text, start);
     }
 
     private get cc() {
@@ -175,12 +175,13 @@ class ParserBase extends NodeBuilder {
         text: string,
         tokens: Iterator<Token, Token>,
         protected errorSink: ErrorSink,
+        tree?: TreeImpl,
     ) {
         const token = tokens.next().value;
         assert(token);
 
         super(
-            new TreeImpl(text, null!),
+            tree ?? new TreeImpl(text, null!),
             {
                 kind: CompositeNodeTypes.Root,
                 children: [],
@@ -303,6 +304,21 @@ export class Parser extends ParserBase {
         return this.tree;
     }
 
+    // Entry point for reparsing part of a file. Parses top-level declarations
+    // until one would start at a token accepted by `isSyncPoint`, and returns
+    // them, followed by the end of file token if it was reached.
+    topLevelDeclsUntil(isSyncPoint: (token: Token) => boolean): SyntaxNodeImpl[] {
+        while (!this.isAtEnd && !isSyncPoint(this.tok)) {
+            this.topLevelDecl();
+        }
+        if (this.isAtEnd) {
+            this.addChild(tokenToSyntaxNode(this.tree, this.tok));
+        }
+
+        assert(this.currentNodes.length === 1);
+        return this.currentNode.children.map(child => child.node);
+    }
+
     //=========================================================================
     // Top-level declarations
 
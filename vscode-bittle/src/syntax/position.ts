@@ -26,6 +26,12 @@ export function pointGt(x1: Point, x2: Point): boolean {
     return pointLt(x2, x1);
 }
 
+/** A position in a text together with its index. */
+export interface TextOffset {
+    index: number;
+    position: Point;
+}
+
 //=============================================================================
 //== Range
 
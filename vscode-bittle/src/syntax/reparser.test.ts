@@ -0,0 +1,121 @@
+import { expect, test } from 'vitest';
+import { composeTextChanges, parse, ParseResult, reparse, TextChange } from './reparser.js';
+import { SyntaxNode } from './tree.js';
+
+const text = `
+// Points
+struct Point {
+    x: Int,
+    y: Int,
+}
+
+func sqr_dst(p1: *Point, p2: *Point): Int {
+    var dx = p2.x - p1.x;
+    var dy = p2.y - p1.y;
+    return dx * dx + dy * dy;
+}
+
+/// The origin
+const ORIGIN_X = 0;
+
+func main(): Int {
+    return 0;
+}
+`;
+
+function edit(text: string, find: string, replacement: string): [string, TextChange] {
+    const startIndex = text.indexOf(find);
+    expect(startIndex).toBeGreaterThanOrEqual(0);
+    return [
+        text.slice(0, startIndex) + replacement + text.slice(startIndex + find.length),
+        {
+            startIndex,
+            oldEndIndex: startIndex + find.length,
+            newEndIndex: startIndex + replacement.length,
+        },
+    ];
+}
+
+function describeResult(result: ParseResult) {
+    const nodes: unknown[] = [];
+    const walk = (node: SyntaxNode) => {
+        nodes.push([node.type, node.startIndex, node.endIndex, node.startPosition, node.endPosition]);
+        node.children.forEach(walk);
+    };
+    walk(result.tree.rootNode);
+    return {
+        tree: result.tree.rootNode.pretty(),
+        nodes,
+        errors: result.errors.toSorted((a, b) =>
+            a.position.row - b.position.row
+            || a.position.column - b.position.column
+            || a.message.localeCompare(b.message)),
+    };
+}
+
+function expectSameAsFullParse(text: string, edits: [string, string][]) {
+    let result = parse(text);
+    for (const [find, replacement] of edits) {
+        const [newText, change] = edit(text, find, replacement);
+        result = reparse(result, newText, change);
+        text = newText;
+        expect(result.tree.text).toBe(text);
+        expect(describeResult(result)).toEqual(describeResult(parse(text)));
+    }
+}
+
+test('edit inside a function body', () => {
+    expectSameAsFullParse(text, [
+        ['var dy', 'var dz'],
+        ['return 0;', 'return 1;\n    return 2;'],
+    ]);
+});
+
+test('edit between declarations', () => {
+    expectSameAsFullParse(text, [
+        ['\n/// The origin', '\n\nstruct Empty {}\n\n/// The origin'],
+        ['struct Empty {}\n', ''],
+    ]);
+});
+
+test('edit in comments', () => {
+    expectSameAsFullParse(text, [
+        ['// Points', '// Points in\n// the plane'],
+        ['/// The origin', '/// The\n/// origin'],
+    ]);
+});
+
+test('edit at the start and end', () => {
+    expectSameAsFullParse(text, [
+        ['\n// Points', 'import "lib";\n// Points'],
+        ['return 0;\n}\n', 'return 0;\n}\nvar x: Int;'],
+    ]);
+});
+
+test('edit that breaks and fixes a declaration', () => {
+    expectSameAsFullParse(text, [
+        ['y: Int,\n}', 'y: Int,\n'],
+        ['y: Int,\n', 'y: Int,\n}'],
+        ['(p1', '(/*p1'],
+        ['(/*p1', '(p1'],
+    ]);
+});
+
+test('reused declarations keep their nodes', () => {
+    const old = parse(text);
+    const [oldStruct, oldFunc] = old.tree.rootNode.children;
+    const [newText, change] = edit(text, 'var dy', 'var dz');
+    const { tree } = reparse(old, newText, change);
+    expect(tree.rootNode.children[0]).toBe(oldStruct);
+    expect(tree.rootNode.children[1]).not.toBe(oldFunc);
+    expect(tree.rootNode.children[0].tree).toBe(tree);
+});
+
+test('compose text changes', () => {
+    const [text1, change1] = edit(text, 'var dx', 'var x');
+    const [composed, change2] = edit(text1, 'return 0', 'return 10');
+    const change = composeTextChanges(change1, change2);
+    expect(composed.slice(0, change.startIndex)).toBe(text.slice(0, change.startIndex));
+    expect(composed.slice(change.newEndIndex)).toBe(text.slice(change.oldEndIndex));
+    expect(describeResult(reparse(parse(text), composed, change))).toEqual(describeResult(parse(composed)));
+});
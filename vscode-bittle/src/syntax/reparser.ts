@@ -0,0 +1,243 @@
+import { CharCursor } from './charCursor.js';
+import { Error, ErrorSink } from './errorSink.js';
+import { tokenize } from './lexer.js';
+import { CompositeNodeTypes } from './nodeTypes.js';
+import { Parser } from './parser.js';
+import { Point, pointEq, pointLt, TextOffset } from './position';
+import { Token } from './token.js';
+import { Tree } from './tree.js';
+import { CompositeNodeImpl, SyntaxNodeImpl, TokenNodeImpl, TreeImpl } from './treeImpl.js';
+
+/**
+ * An edit that replaced `startIndex..oldEndIndex` of a text with the text now
+ * at `startIndex..newEndIndex`.
+ */
+export interface TextChange {
+    startIndex: number;
+    oldEndIndex: number;
+    newEndIndex: number;
+}
+
+/** The change made by applying `first` and then `second`. */
+export function composeTextChanges(first: TextChange, second: TextChange): TextChange {
+    const firstDelta = first.newEndIndex - first.oldEndIndex;
+    const secondDelta = second.newEndIndex - second.oldEndIndex;
+    return {
+        startIndex: Math.min(first.startIndex, second.startIndex),
+        oldEndIndex: second.oldEndIndex >= first.newEndIndex
+            ? Math.max(first.oldEndIndex, second.oldEndIndex - firstDelta)
+            : first.oldEndIndex,
+        newEndIndex: first.newEndIndex >= second.oldEndIndex
+            ? Math.max(second.newEndIndex, first.newEndIndex + secondDelta)
+            : second.newEndIndex,
+    };
+}
+
+export interface ParseResult {
+    tree: Tree;
+    errors: Error[];
+}
+
+export function parse(text: string): ParseResult {
+    const errors: Error[] = [];
+    const errorSink: ErrorSink = {
+        add: (error: Error) => errors.push(error),
+    };
+
+    const tree = new Parser(text, tokenize(text, errorSink), errorSink).top();
+
+    return { tree, errors };
+}
+
+/**
+ * Parses the text of a file after an edit, reusing the top-level declarations
+ * of the previous tree that the edit did not touch.
+ *
+ * A declaration is reparsed when the change overlaps it or the trivia on either
+ * side of it, and a declaration just before the reparsed ones is also
+ * reparsed if it has errors, since the parser may have looked past its end.
+ * Parsing starts after the trailing trivia of the last declaration kept in
+ * front, and stops at the first untouched declaration after the change that it
+ * reaches with the same leading trivia and column. From there on the old
+ * declarations are moved to the new tree with their positions shifted.
+ *
+ * The old tree must not be used afterwards, as its nodes may have moved.
+ */
+export function reparse(old: ParseResult, text: string, change: TextChange): ParseResult {
+    const oldRoot = old.tree.rootNode as SyntaxNodeImpl;
+    const oldNodes = oldRoot.children as SyntaxNodeImpl[];
+    const oldText = old.tree.text;
+    const indexDelta = change.newEndIndex - change.oldEndIndex;
+
+    // The last node is the end of file token
+    const n = oldNodes.length - 1;
+
+    const isTouched = (i: number) => {
+        const extentStart = i > 0 ? oldNodes[i - 1].endIndex : 0;
+        const extentEnd = i + 1 < oldNodes.length ? oldNodes[i + 1].startIndex : oldText.length;
+        return change.startIndex <= extentEnd && extentStart <= change.oldEndIndex;
+    };
+
+    // Declarations with an error, and those whose start has an error, which may
+    // also come from the declaration before
+    const hasErrors = new Array<boolean>(n + 1).fill(false);
+    const hasErrorAtStart = new Array<boolean>(n + 1).fill(false);
+    for (const error of old.errors) {
+        const i = findNodeAt(oldNodes, error.position);
+        hasErrors[i] = true;
+        if (pointEq(error.position, oldNodes[i].startPosition)) {
+            hasErrorAtStart[i] = true;
+            if (i > 0) {
+                hasErrors[i - 1] = true;
+            }
+        }
+    }
+
+    let start = 0;
+    while (start < n && !isTouched(start)) {
+        start++;
+    }
+    while (start > 0 && hasErrors[start - 1]) {
+        start--;
+    }
+
+    const tree = new TreeImpl(text, null!);
+    const errors: Error[] = [];
+    const errorSink: ErrorSink = {
+        add: (error: Error) => errors.push(error),
+    };
+
+    // Keep the declarations in front
+    const nodes: SyntaxNodeImpl[] = [];
+    for (let i = 0; i < start; i++) {
+        oldNodes[i].rebase(tree, { index: 0, row: 0 });
+        nodes.push(oldNodes[i]);
+    }
+    const resumeAt = start > 0 ? endOfTrailingTrivia(oldText, oldNodes[start - 1]) : undefined;
+    for (const error of old.errors) {
+        if (resumeAt && pointLt(error.position, resumeAt.position)) {
+            errors.push(error);
+        }
+    }
+
+    // Old declarations after the change where parsing can stop, by their new
+    // start index
+    const syncPoints = new Map<number, number>();
+    for (let i = start; i <= n; i++) {
+        if (oldNodes[i].startIndex >= change.oldEndIndex && !isTouched(i) && !hasErrorAtStart[i]) {
+            syncPoints.set(oldNodes[i].startIndex + indexDelta, i);
+        }
+    }
+
+    let end = n + 1;
+    let rowDelta = 0;
+    const isSyncPoint = (token: Token) => {
+        const i = syncPoints.get(token.startIndex);
+        if (i === undefined) {
+            return false;
+        }
+        const oldToken = firstToken(oldNodes[i]);
+        if (!oldToken
+            || token.startPosition.column !== oldToken.startPosition.column
+            || !arrayEq(token.leadingTrivia, oldToken.leadingTrivia)
+        ) {
+            return false;
+        }
+        end = i;
+        rowDelta = token.startPosition.row - oldToken.startPosition.row;
+        return true;
+    };
+
+    // Reparse the declarations in between
+    const parser = new Parser(text, tokenize(text, errorSink, resumeAt), errorSink, tree);
+    nodes.push(...parser.topLevelDeclsUntil(isSyncPoint));
+
+    // Keep the declarations after
+    if (end <= n) {
+        const oldStart = oldNodes[end].startPosition;
+        const shift = { index: indexDelta, row: rowDelta };
+        for (let i = end; i <= n; i++) {
+            oldNodes[i].rebase(tree, shift);
+            nodes.push(oldNodes[i]);
+        }
+        for (const error of old.errors) {
+            if (pointLt(oldStart, error.position)) {
+                errors.push({
+                    position: { row: error.position.row + shift.row, column: error.position.column },
+                    message: error.message,
+                });
+            }
+        }
+    }
+
+    tree.rootNode = new CompositeNodeImpl(
+        CompositeNodeTypes.Root,
+        nodes[0].startPosition,
+        nodes[0].startIndex,
+        tree,
+        nodes.map(node => ({ node })),
+    );
+
+    return { tree, errors };
+}
+
+// Index of the top-level node that contains the position, or the one before it
+function findNodeAt(nodes: SyntaxNodeImpl[], position: Point): number {
+    let lo = 0;
+    let hi = nodes.length - 1;
+    while (lo < hi) {
+        const mid = (lo + hi + 1) >> 1;
+        if (pointLt(position, nodes[mid].startPosition)) {
+            hi = mid - 1;
+        } else {
+            lo = mid;
+        }
+    }
+    return lo;
+}
+
+function firstToken(node: SyntaxNodeImpl): Token | undefined {
+    if (node instanceof TokenNodeImpl) {
+        return node.token;
+    }
+    for (const child of node.children as SyntaxNodeImpl[]) {
+        const token = firstToken(child);
+        if (token) {
+            return token;
+        }
+    }
+    return undefined;
+}
+
+function lastToken(node: SyntaxNodeImpl): Token | undefined {
+    if (node instanceof TokenNodeImpl) {
+        return node.token;
+    }
+    const children = node.children as SyntaxNodeImpl[];
+    for (let i = children.length - 1; i >= 0; i--) {
+        const token = lastToken(children[i]);
+        if (token) {
+            return token;
+        }
+    }
+    return undefined;
+}
+
+// Where the lexer continues after the last token of the node
+function endOfTrailingTrivia(text: string, node: SyntaxNodeImpl): TextOffset {
+    const token = lastToken(node)!;
+    const index = token.startIndex + token.lexeme.length;
+    const cursor = new CharCursor(text, {
+        index,
+        position: { row: token.startPosition.row, column: token.startPosition.column + token.lexeme.length },
+    });
+    const end = index + token.trailingTrivia.join('').length;
+    while (cursor.index < end) {
+        cursor.bump();
+    }
+    return { index: cursor.index, position: cursor.pos };
+}
+
+function arrayEq(a: string[], b: string[]): boolean {
+    return a.length === b.length && a.every((x, i) => x === b[i]);
+}
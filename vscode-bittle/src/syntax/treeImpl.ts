@@ -4,6 +4,12 @@ import { Point, pointGt, pointLt, PointRange, rangeContains } from './position';
 import { Token, TokenKind } from './token.js';
 import { ClosestNodes, SyntaxNode, Tree } from './tree.js';
 
+/** How far the text of a node moved between two versions of a file. */
+export interface TextShift {
+    index: number;
+    row: number;
+}
+
 export abstract class SyntaxNodeImpl implements SyntaxNode {
     private _type: string;
     private _startPosition: Point;
@@ -223,6 +229,25 @@ export abstract class SyntaxNodeImpl implements SyntaxNode {
             ? this
             : this.parent?.closest(types) ?? null;
     }
+
+    /**
+     * Moves the subtree into another tree, for reuse after an edit. The text of
+     * the node must be unchanged and start on a line that only moved by whole
+     * rows. The subtree can no longer be used with its old tree.
+     */
+    rebase(tree: Tree, shift: TextShift) {
+        this._tree = tree;
+        if (shift.index !== 0 || shift.row !== 0) {
+            this._startIndex += shift.index;
+            this._startPosition = {
+                row: this._startPosition.row + shift.row,
+                column: this._startPosition.column,
+            };
+        }
+        for (const child of this._children) {
+            child.node.rebase(tree, shift);
+        }
+    }
 }
 
 export class CompositeNodeImpl extends SyntaxNodeImpl {
@@ -257,6 +282,17 @@ export class TokenNodeImpl<Kind extends TokenKind> extends SyntaxNodeImpl {
         return this.startIndex + this._token.lexeme.length;
     }
 
+    override rebase(tree: Tree, shift: TextShift) {
+        super.rebase(tree, shift);
+        if (shift.index !== 0 || shift.row !== 0) {
+            this._token = this.token = {
+                ...this._token,
+                startPosition: this.startPosition,
+                startIndex: this.startIndex,
+            };
+        }
+    }
+
     override pretty(level: number = 0): string {
         let text = '';
         text += indent(level);
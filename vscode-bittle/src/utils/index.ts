@@ -14,6 +14,10 @@ export function unreachable(value: never): never {
     throw new Error(`Unreachable code reached: ${value}`);
 }
 
+export function arrayEq<T>(a: readonly T[], b: readonly T[]): boolean {
+    return a.length === b.length && a.every((x, i) => x === b[i]);
+}
+
 export function isBittleFile(name: string) {
     return name.endsWith('.btl') || name.endsWith('.btls');
 }
@@ -44,6 +44,10 @@ export function interceptExceptionsAsync(target: object, propertyKey: string, de
             logInvocationFinished(target, propertyKey, startTime);
             return result;
         } catch (error) {
+            if (error instanceof vscode.CancellationError) {
+                log.log(`${target.constructor.name}.${propertyKey} cancelled`);
+                throw error;
+            }
             vscode.window.showErrorMessage('Uncaught exception: ' + getErrorDescription(error));
             log.log(error);
             throw error;
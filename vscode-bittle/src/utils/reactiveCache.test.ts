@@ -0,0 +1,85 @@
+import { expect, test, vi } from 'vitest';
+import { ReactiveCache } from './reactiveCache.js';
+
+vi.mock('../log', () => ({ log: { log: () => {} } }));
+
+function setup() {
+    const cache = new ReactiveCache();
+    const inputs = new Map<string, string>([['a', 'x'], ['b', 'y']]);
+    const runs: string[] = [];
+
+    const input = (key: string) => cache.compute(`input:${key}`, () => {
+        runs.push(`input:${key}`);
+        return inputs.get(key)!;
+    });
+    const length = (key: string) => cache.compute(`length:${key}`, () => {
+        runs.push(`length:${key}`);
+        return input(key).length;
+    });
+    const total = () => cache.compute(`total`, () => {
+        runs.push(`total`);
+        return length('a') + length('b');
+    });
+
+    const change = (key: string, value: string) => {
+        inputs.set(key, value);
+        cache.invalidate(`input:${key}`);
+    };
+
+    return { cache, runs, input, total, change };
+}
+
+test('reuses values while nothing changed', () => {
+    const { runs, total } = setup();
+    expect(total()).toBe(2);
+    expect(total()).toBe(2);
+    expect(runs).toEqual(['total', 'length:a', 'input:a', 'length:b', 'input:b']);
+});
+
+test('recomputes what depends on a changed input', () => {
+    const { runs, total, change } = setup();
+    total();
+    runs.length = 0;
+    change('a', 'xxx');
+    expect(total()).toBe(4);
+    expect(runs).toEqual(['input:a', 'length:a', 'total']);
+});
+
+test('stops at values that did not change', () => {
+    const { runs, total, change } = setup();
+    total();
+    runs.length = 0;
+    change('a', 'z');
+    expect(total()).toBe(2);
+    expect(runs).toEqual(['input:a', 'length:a']);
+});
+
+test('peek only returns values that are up to date', () => {
+    const { cache, total, change } = setup();
+    expect(cache.peek('total')).toBeUndefined();
+    total();
+    expect(cache.peek('total')).toBe(2);
+    change('b', 'yy');
+    expect(cache.peek('total')).toBeUndefined();
+    total();
+    expect(cache.peek('total')).toBe(3);
+});
+
+test('untracked reads are not dependencies', () => {
+    const { cache, runs, input, change } = setup();
+    const first = () => cache.compute('first', () => {
+        runs.push('first');
+        return cache.untracked(() => input('a'));
+    });
+    expect(first()).toBe('x');
+    runs.length = 0;
+    change('a', 'w');
+    expect(first()).toBe('x');
+    expect(runs).toEqual([]);
+});
+
+test('detects cycles', () => {
+    const cache = new ReactiveCache();
+    const loop = (): number => cache.compute('loop', () => loop());
+    expect(loop).toThrow('Cyclic dependency detected: loop -> loop');
+});
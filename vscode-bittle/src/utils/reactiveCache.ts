@@ -1,71 +1,150 @@
 import { log } from '../log';
 
+type Entry = {
+    value: unknown;
+    compute: () => unknown;
+    equals: (a: unknown, b: unknown) => boolean;
+    dependencies: string[];
+    changedAt: number;
+    verifiedAt: number;
+    isDirty: boolean;
+};
+
+type Frame = {
+    key: string | undefined;
+    dependencies: Set<string>;
+};
+
+/**
+ * A cache of computed values that records which entries each computation
+ * read, so that invalidating an input only recomputes what depends on it.
+ *
+ * Every entry remembers how to compute itself, the entries it read, the
+ * revision it last changed at, and the revision it was last known to be up to
+ * date at. Invalidating a key only marks that entry dirty and starts a new
+ * revision. When an entry from an older revision is read, its dependencies are
+ * brought up to date first, in the order they were read. If none of them
+ * changed since, the entry is reused without running it again. Otherwise it is
+ * recomputed, and if the new value equals the old one, the old value is kept
+ * and the entry counts as unchanged, so its dependents can be reused in turn.
+ *
+ * Values that are rebuilt on every run, like syntax trees, benefit from this
+ * through an entry derived from them that compares well, like the interface of
+ * a module.
+ */
 export class ReactiveCache {
-    private dependencies = new Map<string, Set<string>>();
-    private dependents = new Map<string, Set<string>>();
-    private values = new Map<string, unknown>();
+    private entries = new Map<string, Entry>();
+    private revision = 0;
 
-    private currentComputations: string[] = [];
+    private frames: Frame[] = [];
 
-    private get currentComputation() {
-        return this.currentComputations[this.currentComputations.length - 1];
+    private get currentFrame(): Frame | undefined {
+        return this.frames[this.frames.length - 1];
     }
 
-    compute<T>(key: string, compute: () => T): T {
-        if (this.values.has(key)) {
-            const value = this.values.get(key);
-            this.track(key);
-            return value as T;
+    compute<T>(key: string, compute: () => T, equals: (a: T, b: T) => boolean = Object.is): T {
+        let entry = this.entries.get(key);
+        if (entry) {
+            this.refresh(key, entry);
+        } else {
+            const [value, dependencies] = this.inScope(key, compute);
+            entry = {
+                value,
+                compute,
+                equals: equals as (a: unknown, b: unknown) => boolean,
+                dependencies,
+                changedAt: this.revision,
+                verifiedAt: this.revision,
+                isDirty: false,
+            };
+            this.entries.set(key, entry);
         }
-
-        const value: T = this.inScope(key, compute);
-
-        this.values.set(key, value);
         this.track(key);
-        return value;
+        return entry.value as T;
     }
 
-    private track(key: string) {
-        if (this.currentComputation) {
-            addNode(this.dependencies, this.currentComputation, key);
-            addNode(this.dependents, key, this.currentComputation);
-        }
+    /** The cached value of a key if it is up to date, without computing it or depending on it. */
+    peek<T>(key: string): T | undefined {
+        const entry = this.entries.get(key);
+        return entry && !entry.isDirty && entry.verifiedAt === this.revision
+            ? entry.value as T
+            : undefined;
     }
 
-    inScope<T>(key: string, compute: () => T) {
-        if (this.currentComputations.includes(key)) {
-            const cycleStart = this.currentComputations.indexOf(key);
-            const cyclePath = [...this.currentComputations.slice(cycleStart), key].join(' -> ');
-            throw new Error(`Cyclic dependency detected: ${cyclePath}`);
-        }
-        this.currentComputations.push(key);
+    /** Runs `compute` without recording what it reads as dependencies of the current computation. */
+    untracked<T>(compute: () => T): T {
+        this.frames.push({ key: undefined, dependencies: new Set() });
         try {
-            log.log(`Computing ${key}`);
             return compute();
         } finally {
-            this.currentComputations.pop();
+            this.frames.pop();
         }
     }
 
-    delete(key: string) {
-        if (!this.values.has(key)) {
+    /** Marks a key as changed, to be recomputed when it is next read. */
+    invalidate(key: string) {
+        const entry = this.entries.get(key);
+        if (!entry || entry.isDirty) {
             return;
         }
         log.log(`Invalidating ${key}`);
-        for (const dep of this.dependents.get(key) ?? []) {
-            this.delete(dep);
+        entry.isDirty = true;
+        this.revision++;
+    }
+
+    private refresh(key: string, entry: Entry) {
+        if (!entry.isDirty && entry.verifiedAt === this.revision) {
+            return;
         }
-        this.dependencies.delete(key);
-        this.dependents.delete(key);
-        this.values.delete(key);
+        if (!entry.isDirty && this.dependenciesUnchanged(entry)) {
+            entry.verifiedAt = this.revision;
+            return;
+        }
+
+        const [value, dependencies] = this.inScope(key, entry.compute);
+        if (!entry.equals(entry.value, value)) {
+            entry.value = value;
+            entry.changedAt = this.revision;
+        } else {
+            log.log(`Unchanged ${key}`);
+        }
+        entry.dependencies = dependencies;
+        entry.verifiedAt = this.revision;
+        entry.isDirty = false;
+    }
+
+    private dependenciesUnchanged(entry: Entry): boolean {
+        for (const dependency of entry.dependencies) {
+            const dependencyEntry = this.entries.get(dependency);
+            if (!dependencyEntry) {
+                return false;
+            }
+            this.refresh(dependency, dependencyEntry);
+            if (dependencyEntry.changedAt > entry.verifiedAt) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    private track(key: string) {
+        this.currentFrame?.dependencies.add(key);
     }
-}
 
-function addNode(map: Map<string, Set<string>>, key: string, value: string) {
-    let set = map.get(key);
-    if (!set) {
-        set = new Set();
-        map.set(key, set);
+    private inScope<T>(key: string, compute: () => T): [T, string[]] {
+        if (this.frames.some(frame => frame.key === key)) {
+            const keys = this.frames.map(frame => frame.key).filter(key => key !== undefined);
+            const cycleStart = keys.indexOf(key);
+            const cyclePath = [...keys.slice(cycleStart), key].join(' -> ');
+            throw new Error(`Cyclic dependency detected: ${cyclePath}`);
+        }
+        const frame: Frame = { key, dependencies: new Set() };
+        this.frames.push(frame);
+        try {
+            log.log(`Computing ${key}`);
+            return [compute(), Array.from(frame.dependencies)];
+        } finally {
+            this.frames.pop();
+        }
     }
-    set.add(value);
 }
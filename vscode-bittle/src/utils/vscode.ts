@@ -27,3 +27,17 @@ export function toVscRange(...args: [Point, Point] | [PointRange]): vscode.Range
         : args;
     return new vscode.Range(toVscPosition(start), toVscPosition(end));
 }
+
+//=============================================================================
+//== Cancellation
+
+/**
+ * Lets other requests and extensions run on the extension host, and then
+ * stops the request if it was cancelled meanwhile.
+ */
+export async function yieldUnlessCancelled(token: vscode.CancellationToken): Promise<void> {
+    await new Promise(resolve => setImmediate(resolve));
+    if (token.isCancellationRequested) {
+        throw new vscode.CancellationError();
+    }
+}